@@ -0,0 +1,200 @@
+// event loop of the elliptic flow (v2) analysis: analysis variants, their histograms and results
+
+#ifndef analysis_h
+#define analysis_h
+
+#include "binning.h"
+#include "flow_kernel.h"
+#include "histogram_bank.h"
+#include "fourier_accumulator.h"
+#include "prefetch_reader.h"
+#include "resampling.h"
+#include "run_stats.h"
+#include "track_store.h"
+#include <TH1.h>
+#include <TGraph.h>
+#include <TGraphErrors.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class particle_tree;
+class SkimCache;
+class TDirectory;
+class TObject;
+class WorkerCheckpoint;
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// event and track selection of an analysis variant (all cuts disabled by default)
+struct Cuts
+{
+  // Zvertex window [cm]
+  bool zvertexCut = false;
+  double zvertexMin = 0.;
+  double zvertexMax = 0.;
+  // track matching: |Mch| < mchMax [sigma]
+  bool mchCut = false;
+  double mchMax = 0.;
+  // pion identification: |isPi| < isPiMax [sigma]
+  bool isPiCut = false;
+  double isPiMax = 0.;
+
+  // columns of the track store needed by the cuts
+  int Columns() const;
+  bool HasTrackCuts() const { return mchCut || isPiCut; }
+  bool PassEvent(const TrackStore &store, int iEvent) const;
+  bool PassTrack(const TrackStore &store, int iTrack) const;
+  // the same from the values (skim cache)
+  bool PassEvent(double zvertex) const;
+  bool PassTrack(double mch, double isPi) const;
+};
+
+// named analysis with its own cuts and binning
+struct Variant
+{
+  std::string name;
+  Cuts cuts;
+  Binning binning;
+
+  // apply a key=value setting: zvertex=<min>,<max>, mch=<max>, ispi=<max> or a binning option without the leading --
+  bool ParseSetting(const std::string &setting);
+};
+
+// read analysis variants from a text file, one per line: <name> [key=value ...]
+bool ReadVariants(const std::string &filename, const Binning &defaultBinning, std::vector<Variant> &variants);
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// histograms filled by looping through the events (one set for every variant and worker thread)
+struct HistogramSet
+{
+  // transverse momentum ditsribution
+  TH1D *pTDistribution;
+  // centrality distribution
+  TH1D *centralityDistribution;
+  // azimuthal distribution(s) for given pT splittings and centrality range ~ materialized into TH1Ds at the end
+  HistogramBank azimuthDistribution;
+  // sums of cos(2 (phi - Psi)) for the Fourier coefficient estimate of v2
+  FourierAccumulator fourier;
+  // comparison of the vectorized kernel to the reference (if requested)
+  KernelCheck kernelCheck;
+  // histograms and sums of the subsamples for the jackknife errors and the measured resolution (nullptr ~ none)
+  Resampling *resampling;
+
+  // create histograms (the suffix distinguishes the worker copies by name), with the given number of subsamples
+  HistogramSet(const Binning &binning, const std::string &suffix = "", int NSubsamples = 0);
+  ~HistogramSet();
+
+  // add the bin contents of another set with the same binning
+  void Add(const HistogramSet &other);
+  // recompute statistics (mean, RMS) from the bin contents ~ independent of the order of merging
+  void ResetStats();
+
+  // write the state (histograms and sums) into a directory of a partial output
+  void WriteState(TDirectory *dir) const;
+  // the state written by WriteState exists and has the binning of this set
+  bool CheckState(TDirectory *dir) const;
+  // add the state written by WriteState, false if it is missing or of a different binning
+  bool AddState(TDirectory *dir);
+};
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// number of events read into the track store at once
+const long unsigned int kBlockSize = 1000;
+
+// settings of the event loop and of the output
+struct AnalysisConfig
+{
+  // centrality classes, pT splitting and azimuthal binning from the command line (default of all variants)
+  Binning binning;
+  // v2 estimator: fit of the azimuthal distributions, mean of cos(2 (phi - Psi)) or both side by side
+  std::string estimator = "fit";
+  // analysis variants evaluated over the same read of the data
+  std::vector<Variant> variants;
+  // variants read from a file are written to their own directories, the single default variant to the top level
+  bool useVariants = false;
+  // use the scalar reference kernel instead of the vectorized one
+  bool scalarKernel = false;
+  // compare the vectorized kernel to the reference on every track
+  bool checkKernel = false;
+  // number of blocks read ahead by the background reader (0 ~ synchronous reading)
+  int prefetchDepth = 4;
+  // size of the TTreeCache [bytes] (0 ~ no cache)
+  Long64_t cacheSize = 32 << 20;
+  // machine readable run statistics (JSON or CSV, empty ~ none)
+  std::string statsFileName;
+  // number of subsamples for the jackknife errors and the resolution from three sub-events (0 ~ none)
+  int subsamples = 0;
+
+  // columns of the track store needed by any of the variants
+  int Columns() const;
+  // settings that determine the state written to partial outputs (variants with their cuts and binning, subsamples and kernel)
+  // as text ~ stored in every partial output, state written with other settings is not added (the estimator is applied to
+  // the same state, it is not part of it)
+  std::string Fingerprint() const;
+  // parse the options common to the programs (the others are left in the list) and set up the variants, false on errors
+  bool ParseOptions(std::vector<std::string> &options);
+  // usage of the common options
+  static void PrintOptions();
+};
+
+// fill the histograms of a variant from the events of a block
+// (entryOffset ~ entry number of the first event of the tree in the whole input, for the subsamples of the events)
+void AnalyzeBlock(const TrackStore &store, HistogramSet &h, const Variant &variant, const AnalysisConfig &config, TrackBuffer &tracks,
+                  Long64_t entryOffset = 0);
+// loop through events [first, last) of the given tree block by block and fill the histograms of every variant
+// (the reader counters and the time of the track loop are added to stats, snapshots are written through the checkpoint;
+// a tree of a part of the input file list gives the entry number of its first event in the whole list as entryOffset)
+void AnalyzeEvents(particle_tree &p, long unsigned int first, long unsigned int last, std::vector<HistogramSet *> &h,
+                   const AnalysisConfig &config, bool monitor, RunStats &stats, WorkerCheckpoint *checkpoint = nullptr,
+                   Long64_t entryOffset = 0);
+// fill the histograms of a variant from events [first, last) of the skim cache, read in place from the memory map
+void AnalyzeSkimBlock(const SkimCache &cache, Long64_t first, Long64_t last, HistogramSet &h, const Variant &variant,
+                      const QuantizedKernel &kernel, TrackBuffer &tracks);
+// loop through events [first, last) of the skim cache block by block, as AnalyzeEvents
+void AnalyzeSkimEvents(const SkimCache &cache, long unsigned int first, long unsigned int last, std::vector<HistogramSet *> &h,
+                       const AnalysisConfig &config, bool monitor, RunStats &stats, WorkerCheckpoint *checkpoint = nullptr);
+// false if the skim cache does not cover the pT binning of every variant
+bool CheckSkimBinning(const SkimCache &cache, const AnalysisConfig &config);
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// v2 graphs of a centrality class with and without reaction plane resolution correction
+struct V2Graphs
+{
+  // with correction
+  TGraph *result;
+  TGraphErrors *error;
+  // without correction
+  TGraph *resultNonCorr;
+  TGraphErrors *errorNonCorr;
+
+  // the label is appended to the names, e.g. " (Fourier)"
+  V2Graphs(int NpT, const std::pair<int, int> &centrality, const std::string &label = "");
+  // set point from the uncorrected v2, corrected via the reaction plane resolution
+  void SetPoint(int ipT, double pT, double v2NonCorr, double v2ErrNonCorr, double RPMean);
+  void Write() const;
+};
+
+// determine v2 (estimator: fit, fourier or both) and write all histograms and graphs of a variant into the directory
+void WriteResults(const HistogramSet &h, const Binning &binning, const std::string &estimator, TDirectory *dir, RunStats &stats);
+// determine v2 and write the results of all variants to the output file
+void WriteOutput(const std::string &outFileName, const std::vector<HistogramSet *> &h, const AnalysisConfig &config, RunStats &stats);
+// print the run statistics and write them to the statistics file (if requested)
+void ReportStats(const RunStats &stats, const AnalysisConfig &config, double wallSeconds, int threads, const std::string &label);
+
+// write the state of every variant into its own directory of a partial output file, with the counters of the event loop
+// and the given extra objects (through a temporary file renamed at the end ~ an existing partial output is always complete)
+bool WritePartial(const std::string &filename, const std::vector<HistogramSet *> &h, const AnalysisConfig &config, const RunStats &stats,
+                  const std::vector<std::pair<std::string, const TObject *>> &extra = {});
+// add the state stored in a partial output file, false (and nothing added) if it is missing, was written with other settings
+// (AnalysisConfig::Fingerprint) or does not match the variants
+bool AddPartial(const std::string &filename, std::vector<HistogramSet *> &h, const AnalysisConfig &config, RunStats &stats);
+// input files (empty if not stored) of a partial output file, false if it was not read or was written with other settings
+bool ReadPartialInfo(const std::string &filename, const AnalysisConfig &config, std::string &inputFiles);
+// newline separated list of input files, as stored in partial outputs
+std::string JoinFileNames(const std::vector<std::string> &files);
+
+#endif
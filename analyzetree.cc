@@ -3,6 +3,10 @@
 // including used libraries
 #define particle_tree_cxx
 #include "particle_tree.h"
+#include "analysis.h"
+#include "file_parallel.h"
+#include "checkpoint.h"
+#include "skim_cache.h"
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -11,6 +15,7 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <thread>
 #include <TF1.h>
 #include <TH2.h>
 #include <TStyle.h>
@@ -20,246 +25,319 @@
 #include <TGraph.h>
 #include <TGraphErrors.h>
 #include <TLatex.h>
+#include <TStopwatch.h>
 
 // ------------------------------------------------------------------------------------------------------------------------------
 
 // main function
 int main(int argc, const char **argv)
 {
-  // centrality bounds
-  int NC = 2;
-  std::pair<int, int> centrality1 = {0, 30};
-  std::pair<int, int> centrality2 = {40, 70};
-  std::vector<std::pair<int, int>> centralities = {centrality1, centrality2};
-  // transverse momentum splitting
-  int NpT = (int)(2. / 0.1) - 1;
-  std::vector<double> pTSplitting(static_cast<size_t>(NpT));
-  double pTInit = 0.1;
-  double pTDelta = 0.1;
-  std::generate(pTSplitting.begin(), pTSplitting.end(), [&]() { return pTInit += pTDelta; });
-
-  // ------------------------------------------------------------------------------------------------------------------------------
-
-  // contiainers for elliptic flow (v2) results
-  // with reaction plane resolution correction
-  std::vector<TGraph *> v2Result(NC);
-  std::vector<TGraphErrors *> v2Error(NC);
-  // without reaction plane resolution correction
-  std::vector<TGraph *> v2ResultNonCorr(NC);
-  std::vector<TGraphErrors *> v2ErrorNonCorr(NC);
-
-  // ------------------------------------------------------------------------------------------------------------------------------
-
-  // mean reaction plane resolutions (computed somewhere else...) for the centrality classes
-  std::vector<double> RPMeans = {0.678076519159388, 0.5962794418797447};
-
-  // ------------------------------------------------------------------------------------------------------------------------------
+  // separating options (--name) from positional arguments
+  std::vector<std::string> args;
+  std::vector<std::string> options;
+  for (int iArg = 1; iArg < argc; iArg++)
+    (std::string(argv[iArg]).compare(0, 2, "--") == 0 ? options : args).push_back(argv[iArg]);
+  // binning, estimator, variants and event loop settings
+  AnalysisConfig config;
+  if (!config.ParseOptions(options))
+    std::exit(-1);
+  // file-parallel mode: number of files per job (0 ~ all events through one chain) and directory of the partial outputs
+  int filesPerJob = 0;
+  std::string partialDir;
+  // checkpoints: events between the snapshots of every worker (0 ~ none), their directory and resuming from them
+  long long checkpointEvents = 0;
+  std::string checkpointDir;
+  bool resume = false;
+  for (const auto &option : options)
+  {
+    if (option.compare(0, 13, "--checkpoint=") == 0)
+      checkpointEvents = std::max(0ll, atoll(option.substr(13).c_str()));
+    else if (option.compare(0, 17, "--checkpoint-dir=") == 0)
+      checkpointDir = option.substr(17);
+    else if (option == "--resume")
+      resume = true;
+    else if (option == "--file-parallel")
+      filesPerJob = 1;
+    else if (option.compare(0, 16, "--file-parallel=") == 0)
+      filesPerJob = std::max(1, atoi(option.substr(16).c_str()));
+    else if (option.compare(0, 11, "--partials=") == 0)
+      partialDir = option.substr(11);
+    else
+    {
+      std::cout << "Unknown option " << option << std::endl;
+      std::exit(-1);
+    }
+  }
 
   // checking number of arguments
-  if (argc < 2)
+  if (args.size() < 2)
   {
-    std::cout << "Usage: " << argv[0] << " input file name> <output file name> <max events=-1>" << std::endl;
+    std::cout << "Usage: " << argv[0] << " <input file name (.root, file list or .skim)> <output file name> <max events=-1> <threads=1 (0 ~ all cores)>" << std::endl;
+    AnalysisConfig::PrintOptions();
+    std::cout << "         --file-parallel[=<files per job>] (jobs of the file list in parallel processes, <threads> of them at once)," << std::endl;
+    std::cout << "         --partials=<dir> (partial outputs of the jobs, default <output file name>.partials)" << std::endl;
+    std::cout << "         --checkpoint=<events> (snapshot of every worker after this many events), --resume (continue from the snapshots)," << std::endl;
+    std::cout << "         --checkpoint-dir=<dir> (snapshots, default <output file name>.checkpoints)" << std::endl;
     std::exit(-1);
   }
   // reading argument ~ input/output file names
-  std::string inFileName(argv[1]);
-  std::string outFileName(argv[2]);
+  std::string inFileName(args[0]);
+  std::string outFileName(args[1]);
   std::cout << "Writing to " << outFileName << std::endl;
   // max number of events to process
   int NMaxEvent = -1;
-  if (argc >= 4)
-    NMaxEvent = atoi(argv[3]);
+  if (args.size() >= 3)
+    NMaxEvent = atoi(args[2].c_str());
   if (NMaxEvent < 1)
     NMaxEvent = -1;
+  // number of worker threads
+  int NThreads = 1;
+  if (args.size() >= 4)
+    NThreads = atoi(args[3].c_str());
+  if (NThreads < 1)
+    NThreads = std::max(1u, std::thread::hardware_concurrency());
+  // the worker threads and the background readers use ROOT concurrently ~ thread safety is enabled before any ROOT object exists
+  if (NThreads > 1 || config.prefetchDepth > 0)
+    ROOT::EnableThreadSafety();
+  // wall time of the whole run
+  TStopwatch wallTime;
+  wallTime.Start();
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // centrality bounds and transverse momentum splitting of the variants
+  int NVariants = (int)config.variants.size();
+  for (const auto &variant : config.variants)
+  {
+    if (config.useVariants)
+      std::cout << "Variant " << variant.name << ":" << std::endl;
+    variant.binning.Print();
+  }
 
   // ------------------------------------------------------------------------------------------------------------------------------
 
   // CREATE HISTOGRAMS TO BE FILLED BY LOOPING THROUGH ALL EVENTS
-  // transverse momentum ditsribution
-  TH1 *pTDistribution = new TH1D("pTDistribution", "pT distribution", 100, 0, 2);
-  // centrality distribution
-  TH1 *centralityDistribution = new TH1D("centralityDistribution", "Centrality distribution", 100, 0, 100);
-  // azimuthal distribution(s) for given pT splittings and centrality range
-  std::vector<std::vector<TH1D *>> azimuthDistribution(2, std::vector<TH1D *>(NpT));
-  // vector of vector ~ possible update to row/column-major vector (better memory handling)
-  for (int iCentr = 0; iCentr < NC; iCentr++)
-    for (int ipT = 0; ipT < NpT; ipT++)
-      azimuthDistribution[iCentr][ipT] = new TH1D(Form("azimuthDistribution_Centrality%i_pT%i", iCentr, ipT),
-                                                  "Azimuthal distribution", 100, -M_PI_2, M_PI_2);
+  // histograms are owned by the code instead of the current directory ~ worker copies are created and deleted concurrently
+  TH1::AddDirectory(kFALSE);
+  // timers and counters of the run
+  RunStats stats;
+  std::vector<HistogramSet *> histograms(NVariants);
+  for (int iVariant = 0; iVariant < NVariants; iVariant++)
+    histograms[iVariant] = new HistogramSet(config.variants[iVariant].binning, "", config.subsamples);
 
   // ------------------------------------------------------------------------------------------------------------------------------
 
-  // INITIALIZE particle_tree OBJECT
-  particle_tree p(inFileName.c_str());
-  if (p.fChain)
-    std::cout << "Tree initialized" << std::endl;
+  // input root files (a single one or those listed in a text file) or the skim cache written by skimtree.exe
+  bool skimInput = inFileName.size() >= 5 && inFileName.compare(inFileName.size() - 5, 5, ".skim") == 0;
+  std::vector<std::string> files;
+  if (skimInput || (inFileName.size() >= 5 && inFileName.compare(inFileName.size() - 5, 5, ".root") == 0))
+    files.push_back(inFileName);
   else
+    files = particle_tree::ReadFileList(inFileName.c_str());
+  if (files.empty())
   {
-    std::cout << "No tree found." << std::endl;
+    std::cout << "No files listed in " << inFileName << std::endl;
     std::exit(-1);
   }
 
   // ------------------------------------------------------------------------------------------------------------------------------
 
-  // DETERMINE HOW MANY EVENTS TO RUN ON
-  long unsigned int NEvents = p.fChain->GetEntries();
-  if (NMaxEvent > 0 && NMaxEvent < (int)NEvents)
-    NEvents = NMaxEvent;
-  std::cout << "Will run on " << NEvents << " events (out of " << p.fChain->GetEntries() << ")." << std::endl;
-
-  // ------------------------------------------------------------------------------------------------------------------------------
-
-  // LOOP THROUGH EVENTS IN THE GIVEN DATASET
-  for (long unsigned int iEvent = 0; iEvent < NEvents; iEvent++)
+  // FILE-PARALLEL MODE ~ every job of the file list runs in its own process, the partial outputs are merged here
+  if (filesPerJob > 0)
   {
-    // MONITOR PROGRESS THROUGH STDERR OUTPUT
-    if (iEvent > 0 && iEvent % 1000 == 0)
-      std::cout << ".";
-    if (iEvent > 0 && iEvent % 10000 == 0)
-      std::cout << "Analyzing event #" << iEvent << std::endl;
-
-    // ------------------------------------------------------------------------------------------------------------------------------
+    if (NMaxEvent > 0)
+      std::cout << "All events of the files are analyzed in file-parallel mode (max events is ignored)." << std::endl;
+    // partial outputs play the role of checkpoints ~ a rerun only processes the missing files
+    if (checkpointEvents > 0 || resume)
+    {
+      std::cout << "Checkpoints are not used in file-parallel mode (rerun to continue from the partial outputs)." << std::endl;
+      std::exit(-1);
+    }
+    if (skimInput)
+    {
+      std::cout << "The skim cache is analyzed by threads of one process (file-parallel mode needs a file list)." << std::endl;
+      std::exit(-1);
+    }
+    if (partialDir.empty())
+      partialDir = outFileName + ".partials";
 
-    // LOAD EVENT DATA INTO particle_tree OBJECT
-    p.GetEntry(iEvent);
+    std::vector<std::string> partials;
+    if (!RunFileJobs(files, filesPerJob, NThreads, partialDir, config, partials))
+    {
+      std::cout << "Not all files were processed, rerun to retry the missing ones (done files are kept in " << partialDir << ")" << std::endl;
+      std::exit(-1);
+    }
+    // merge partial outputs in the order of the file list
+    {
+      ScopedTimer timer(stats.merge);
+      for (const auto &partial : partials)
+        if (!AddPartial(partial, histograms, config, stats))
+          std::exit(-1);
+      for (int iVariant = 0; iVariant < NVariants; iVariant++)
+        histograms[iVariant]->ResetStats();
+    }
+    WriteOutput(outFileName, histograms, config, stats);
+    ReportStats(stats, config, wallTime.RealTime(), NThreads, inFileName);
+    return 0;
+  }
 
-    // ------------------------------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------------------------------
 
-    // reaction plane
-    double reactionPlane = p.ReactionPlane;
-    // centrality
-    double centrality = p.Centrality;
-    centralityDistribution->Fill(centrality);
+  // INITIALIZE particle_tree OBJECT, or map the skim cache ~ shared by all threads without copies
+  particle_tree *p = nullptr;
+  SkimCache skim;
+  Long64_t NEntries = 0;
+  if (skimInput)
+  {
+    if (!skim.Open(inFileName))
+    {
+      std::cout << "Skim cache was not opened: " << skim.GetError() << std::endl;
+      std::exit(-1);
+    }
+    if (!CheckSkimBinning(skim, config))
+      std::exit(-1);
+    std::cout << "Skim cache initialized (pT quantized up to " << skim.PTMax() << " GeV/c)" << std::endl;
+    NEntries = skim.NEvents();
+  }
+  else
+  {
+    p = new particle_tree(inFileName.c_str());
+    if (p->fChain)
+      std::cout << "Tree initialized" << std::endl;
+    else
+    {
+      std::cout << "No tree found." << std::endl;
+      std::exit(-1);
+    }
+    NEntries = p->fChain->GetEntries();
+  }
 
-    // ------------------------------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------------------------------
 
-    // choose centrality range (initialize to some meaningless value) ~ [0, 30] vs. [40, 70]
-    int centralityRange = -1;
-    if (centrality >= centrality1.first && centrality <= centrality1.second)
-      centralityRange = 0;
-    else if (centrality >= centrality2.first && centrality <= centrality2.second)
-      centralityRange = 1;
-    else
-      continue;
+  // DETERMINE HOW MANY EVENTS TO RUN ON
+  long unsigned int NEvents = NEntries;
+  if (NMaxEvent > 0 && NMaxEvent < (int)NEvents)
+    NEvents = NMaxEvent;
 
-    // ------------------------------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------------------------------
 
-    // LOOP THROUGH ALL PARTICLES OF THE GIVEN EVENT
-    for (int iPart = 0; iPart < p.Ntracks; iPart++)
+  // CHECKPOINTS ~ the histograms of the entry ranges done before are loaded and these entries are skipped when resuming
+  CheckpointStore *checkpoints = nullptr;
+  EntryRanges done;
+  if (checkpointEvents > 0 || resume)
+  {
+    if (checkpointDir.empty())
+      checkpointDir = outFileName + ".checkpoints";
+    checkpoints = new CheckpointStore(checkpointDir, files);
+    if (resume && !checkpoints->Load(histograms, config, done))
+      std::exit(-1);
+    if (!resume && checkpoints->Exists())
     {
-      // CALCULATE SOME VARIABLES AND FILL THEM INTO A HISTOGRAMS
-      // transverse momentum
-      double pT = sqrt(p.px[iPart] * p.px[iPart] + p.py[iPart] * p.py[iPart]);
-      pTDistribution->Fill(pT);
-      if (pT > 2.)
-        continue;
-
-      // ------------------------------------------------------------------------------------------------------------------------------
+      std::cout << "Checkpoints found in " << checkpointDir << ", continue with --resume or remove them." << std::endl;
+      std::exit(-1);
+    }
+  }
+  EntryRanges todo = MissingRanges(done, NEvents);
+  long unsigned int NTodo = 0;
+  for (const auto &range : todo)
+    NTodo += range.second - range.first;
+  std::cout << "Will run on " << NTodo << " events (out of " << NEntries << ", " << NEvents - NTodo << " done before)." << std::endl;
 
-      // choose transverse momentum range (initialize to some meaningless value)
-      int pTRange = -1;
-      double pTTemp = 0.1;
-      while (pTTemp <= pT)
-        pTTemp += 0.1, pTRange++;
+  // ------------------------------------------------------------------------------------------------------------------------------
 
-      // ------------------------------------------------------------------------------------------------------------------------------
+  // SPLIT EVENTS INTO CONTIGUOUS RANGES ~ every worker gets its own ranges, reader and histogram sets (one per variant)
+  NThreads = std::max(1, std::min(NThreads, (int)NTodo));
+  std::vector<EntryRanges> workerRanges = SplitRanges(todo, NThreads);
+  std::vector<WorkerCheckpoint *> workerCheckpoints(NThreads, nullptr);
+  if (checkpointEvents > 0)
+    for (int iThread = 0; iThread < NThreads; iThread++)
+      workerCheckpoints[iThread] = new WorkerCheckpoint(*checkpoints, iThread, checkpointEvents);
+  std::vector<std::vector<HistogramSet *>> workerHistograms(NThreads, std::vector<HistogramSet *>(NVariants));
+  for (int iThread = 0; iThread < NThreads; iThread++)
+    for (int iVariant = 0; iVariant < NVariants; iVariant++)
+      workerHistograms[iThread][iVariant] = new HistogramSet(config.variants[iVariant].binning, Form("_%s_worker%i", config.variants[iVariant].name.c_str(), iThread),
+                                                             config.subsamples);
 
-      // calculate azimuthal angle for given particle (in lab)
-      double phi = std::atan2(p.py[iPart], p.px[iPart]);
-      // calculate azimuthal angle for given particle (in reaction plane)
-      double phiRP = phi - reactionPlane;
-      // fix to [-pi / 2, pi / 2]
-      while (phiRP > M_PI_2)
-        phiRP -= M_PI;
-      while (phiRP < -M_PI_2)
-        phiRP += M_PI;
+  // ------------------------------------------------------------------------------------------------------------------------------
 
-      // add to specific histogram
-      azimuthDistribution[centralityRange][pTRange]->Fill(phiRP);
-    }
+  // LOOP THROUGH EVENTS IN THE GIVEN DATASET ~ every event is read once for all variants
+  std::vector<RunStats> workerStats(NThreads);
+  // ranges of a worker from the skim cache or through the given tree
+  auto analyzeRanges = [&](int iThread, particle_tree *tree) {
+    for (const auto &range : workerRanges[iThread])
+      if (skimInput)
+        AnalyzeSkimEvents(skim, range.first, range.second, workerHistograms[iThread], config, iThread == 0, workerStats[iThread],
+                          workerCheckpoints[iThread]);
+      else
+        AnalyzeEvents(*tree, range.first, range.second, workerHistograms[iThread], config, iThread == 0, workerStats[iThread],
+                      workerCheckpoints[iThread]);
+  };
+  if (NThreads == 1)
+    analyzeRanges(0, p);
+  else
+  {
+    std::cout << "Running on " << NThreads << " threads." << std::endl;
+    std::vector<std::thread> workers;
+    for (int iThread = 0; iThread < NThreads; iThread++)
+      workers.emplace_back([&, iThread]() {
+        // TChain is not thread safe ~ every worker reads through its own particle_tree object
+        if (skimInput)
+          analyzeRanges(iThread, nullptr);
+        else
+        {
+          particle_tree workerTree(inFileName.c_str());
+          analyzeRanges(iThread, &workerTree);
+        }
+      });
+    for (auto &worker : workers)
+      worker.join();
   }
   // line break
   std::cout << std::endl;
 
-  // ------------------------------------------------------------------------------------------------------------------------------
-
-  // MAKE FIT(S) to determine elliptic flow (v2)
-  // define ansatz ~ 1D Fourier expansion in the azimuthal angle [-pi / 2, pi / 2]
-  TF1 *FourierFitFunc = new TF1("FourierFit", "[0] + [1] * 2 * cos(2 * x)", -M_PI_2, M_PI_2);
-  // loop through centralities and pT splittings
-  for (int iCentr = 0; iCentr < NC; iCentr++)
+  // counters summed over the workers
+  for (int iThread = 0; iThread < NThreads; iThread++)
+    stats.Add(workerStats[iThread]);
+  stats.bytesRead += TFile::GetFileBytesRead();
+  // a read error stops the loading of a block early ~ the run fails instead of missing events silently
+  if (stats.reader.events != (long long)NTodo)
   {
-    // save results to...
-    // with correction
-    v2Result[iCentr] = new TGraph(NpT);
-    v2Result[iCentr]->SetName(Form("v_{2} with centrality %i-%i [%]", centralities[iCentr].first, centralities[iCentr].second));
-    v2Result[iCentr]->SetTitle(Form("v_{2} with centrality %i-%i [%]", centralities[iCentr].first, centralities[iCentr].second));
-    v2Error[iCentr] = new TGraphErrors(NpT);
-    v2Error[iCentr]->SetName(Form("v_{2} errors with centrality %i-%i [%]", centralities[iCentr].first, centralities[iCentr].second));
-    v2Error[iCentr]->SetTitle(Form("v_{2} with centrality %i-%i [%]", centralities[iCentr].first, centralities[iCentr].second));
-    // without correction
-    v2ResultNonCorr[iCentr] = new TGraph(NpT);
-    v2ResultNonCorr[iCentr]->SetName(Form("v_{2} with centrality %i-%i [%] (without correction)", centralities[iCentr].first, centralities[iCentr].second));
-    v2ResultNonCorr[iCentr]->SetTitle(Form("v_{2} with centrality %i-%i [%] (without correction)", centralities[iCentr].first, centralities[iCentr].second));
-    v2ErrorNonCorr[iCentr] = new TGraphErrors(NpT);
-    v2ErrorNonCorr[iCentr]->SetName(Form("v_{2} errors with centrality %i-%i [%] (without correction)", centralities[iCentr].first, centralities[iCentr].second));
-    v2ErrorNonCorr[iCentr]->SetTitle(Form("v_{2} with centrality %i-%i [%] (without correction)", centralities[iCentr].first, centralities[iCentr].second));
+    std::cout << "Read " << stats.reader.events << " of " << NTodo << " events of " << inFileName << "!" << std::endl;
+    std::exit(-1);
+  }
 
-    // loop for pT values
-    for (int ipT = 0; ipT < NpT; ipT++)
+  // merge worker histograms in a fixed order ~ bin contents are sums of counts, hence identical to the serial run
+  {
+    ScopedTimer timer(stats.merge);
+    for (int iVariant = 0; iVariant < NVariants; iVariant++)
     {
-      // make fit
-      TFitResultPtr r = azimuthDistribution[iCentr][ipT]->Fit(FourierFitFunc, "S");
-
-      // constant term
-      double A = r->Parameter(0);
-      // coefficient for 2 * cos(2 * x)
-      double B = r->Parameter(1);
-      // get errors
-      double AErr = r->ParError(0);
-      double BErr = r->ParError(1);
-      // get covariance
-      double ABCov = r->CovMatrix(1, 0);
-
-      // elliptic flow (v2) and correction via reaction plane resolution
-      double v2NonCorr = B / A;
-      double v2 = B / A / RPMeans[iCentr];
-      // error estimation through error propagation
-      double v2ErrNonCorr = std::abs(B / A) * std::sqrt((AErr * AErr) / (A * A) + (BErr * BErr) / (B * B) - 2 * ABCov / (A * B));
-      double v2Err = std::abs(B / A) * std::sqrt((AErr * AErr) / (A * A) + (BErr * BErr) / (B * B) - 2 * ABCov / (A * B)) / RPMeans[iCentr];
-
-      std::cout << v2 << " +/-" << v2Err << std::endl;
-
-      v2ResultNonCorr[iCentr]->SetPoint(ipT, pTSplitting[ipT], v2NonCorr);
-      v2ErrorNonCorr[iCentr]->SetPoint(ipT, pTSplitting[ipT], v2NonCorr);
-      v2ErrorNonCorr[iCentr]->SetPointError(ipT, 0., v2ErrNonCorr);
-
-      v2Result[iCentr]->SetPoint(ipT, pTSplitting[ipT], v2);
-      v2Error[iCentr]->SetPoint(ipT, pTSplitting[ipT], v2);
-      v2Error[iCentr]->SetPointError(ipT, 0., v2Err);
+      for (int iThread = 0; iThread < NThreads; iThread++)
+      {
+        histograms[iVariant]->Add(*workerHistograms[iThread][iVariant]);
+        delete workerHistograms[iThread][iVariant];
+      }
+      histograms[iVariant]->ResetStats();
     }
   }
-  // ------------------------------------------------------------------------------------------------------------------------------
+  // the kernel does not depend on the cuts ~ the check of the first variant covers all tracks
+  if (config.checkKernel)
+    histograms[0]->kernelCheck.Print();
 
-  // WRITE ALL HISTOGRAMS TO THE OUTPUT ROOT FILE
-  TFile *f = new TFile(outFileName.c_str(), "RECREATE");
-  if (!f->IsWritable())
-    std::cout << "File " << outFileName << " was not opened!" << std::endl;
-  else
-    std::cout << "Analysis done, writing histograms to " << outFileName << std::endl;
-  f->cd();
-  pTDistribution->Write();
-  centralityDistribution->Write();
-  for (int i = 0; i < NC; i++)
+  // snapshot of everything done so far ~ a later --resume only analyzes entries of appended input files
+  if (checkpoints)
   {
-    v2Result[i]->Write();
-    v2Error[i]->Write();
-    v2ResultNonCorr[i]->Write();
-    v2ErrorNonCorr[i]->Write();
+    for (const auto &range : todo)
+      AddRange(done, range.first, range.second);
+    if (!checkpoints->Consolidate(histograms, config, stats, done))
+      std::cout << "Checkpoint was not written!" << std::endl;
+    for (auto checkpoint : workerCheckpoints)
+      delete checkpoint;
+    delete checkpoints;
   }
-  for (int iCentr = 0; iCentr < NC; iCentr++)
-    for (int ipT = 0; ipT < NpT; ipT++)
-      azimuthDistribution[iCentr][ipT]->Write();
-  f->Write();
-  f->Close();
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // DETERMINE elliptic flow (v2) AND WRITE ALL HISTOGRAMS TO THE OUTPUT ROOT FILE
+  WriteOutput(outFileName, histograms, config, stats);
+  ReportStats(stats, config, wallTime.RealTime(), NThreads, inFileName);
 }
@@ -0,0 +1,52 @@
+// binning of the analysis: centrality classes (with reaction plane resolutions), pT splitting and azimuthal histograms
+
+#ifndef binning_h
+#define binning_h
+
+#include "flow_kernel.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+class Binning
+{
+public:
+  // centrality bounds (inclusive) ~ an event belongs to the first class containing it
+  std::vector<std::pair<int, int>> centralities;
+  // mean reaction plane resolutions for the centrality classes
+  std::vector<double> RPMeans;
+  // pT edges, upper pT limit and azimuthal axis of the track kernel
+  KernelBinning track;
+
+  // the original binning: 0-30% and 40-70%, 0.1 GeV pT bins in [0.1, 2]
+  Binning();
+
+  // read settings from a text file, one setting per line (see README)
+  bool ReadFile(const std::string &filename);
+  // apply one command line option (--binning=, --centrality=, --pt-uniform=, --pt-edges=, --phi-bins=), false if unknown
+  bool ParseOption(const std::string &option, bool &ok);
+  // build the lookup tables, must be called after changing the settings
+  bool Finalize();
+
+  // centrality class of an event in O(1), -1 if none
+  int CentralityClass(int centrality) const
+  {
+    return (unsigned)centrality < fCentralityLookup.size() ? fCentralityLookup[centrality] : -1;
+  }
+
+  int NC() const { return (int)centralities.size(); }
+  int NpT() const { return track.NpT(); }
+  // pT value representing bin ipT in the v2 graphs (upper edge, as in the original pT splitting)
+  double PT(int ipT) const { return track.pTEdges[ipT + 1]; }
+
+  void Print() const;
+
+private:
+  bool SetCentralities(const std::string &list);
+  bool SetPTUniform(double low, double high, double width);
+  bool SetPTEdges(const std::vector<double> &edges);
+
+  std::vector<int> fCentralityLookup;
+};
+
+#endif
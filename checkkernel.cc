@@ -0,0 +1,107 @@
+// standalone check of the vectorized track kernel: bin mismatches against the reference and throughput of both on random tracks
+
+// including used libraries
+#include "flow_kernel.h"
+#include "binning.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// main function
+int main(int argc, const char **argv)
+{
+  // separating options (--name) from positional arguments
+  std::vector<std::string> args;
+  Binning binning;
+  double maxMismatch = 1e-5;
+  for (int iArg = 1; iArg < argc; iArg++)
+  {
+    std::string arg(argv[iArg]);
+    bool ok = true;
+    if (arg.compare(0, 15, "--max-mismatch=") == 0)
+      maxMismatch = atof(arg.substr(15).c_str());
+    else if (binning.ParseOption(arg, ok))
+    {
+      if (!ok)
+        std::exit(-1);
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cout << "Usage: " << argv[0] << " <No. tracks=1000000> <seed=1> [--max-mismatch=1e-5] [binning options]" << std::endl;
+      std::exit(-1);
+    }
+    else
+      args.push_back(arg);
+  }
+  if (!binning.Finalize())
+    std::exit(-1);
+  long long NTracks = args.size() >= 1 ? atoll(args[0].c_str()) : 1000000;
+  TRandom3 random(args.size() >= 2 ? atoi(args[1].c_str()) : 1);
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // GENERATE EVENTS ~ spectrum as in gentree.cc, reaction planes over the whole circle, a few tracks at exact pT edges
+  std::vector<Float_t> px, py;
+  std::vector<double> reactionPlanes;
+  std::vector<long long> offsets(1, 0);
+  const std::vector<double> &edges = binning.track.pTEdges;
+  while ((long long)px.size() < NTracks)
+  {
+    reactionPlanes.push_back(random.Uniform(-M_PI, M_PI));
+    int NPart = std::min(NTracks - (long long)px.size(), (long long)random.Poisson(30.));
+    for (int iPart = 0; iPart < NPart; iPart++)
+    {
+      double pT = random.Uniform() < 0.01 ? edges[(int)random.Uniform(0., edges.size())] : 0.1 + random.Exp(0.4);
+      double phi = random.Uniform(-M_PI, M_PI);
+      px.push_back(pT * std::cos(phi));
+      py.push_back(pT * std::sin(phi));
+    }
+    offsets.push_back(px.size());
+  }
+  int NEvents = (int)reactionPlanes.size();
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // BIN MISMATCHES
+  KernelCheck check;
+  for (int iEvent = 0; iEvent < NEvents; iEvent++)
+    CompareTrackKernels(&px[offsets[iEvent]], &py[offsets[iEvent]], offsets[iEvent + 1] - offsets[iEvent], reactionPlanes[iEvent],
+                        binning.track, check);
+  check.Print();
+
+  // THROUGHPUT OF BOTH KERNELS
+  TrackBuffer tracks;
+  double seconds[2];
+  for (int iKernel = 0; iKernel < 2; iKernel++)
+  {
+    TStopwatch timer;
+    timer.Start();
+    for (int iEvent = 0; iEvent < NEvents; iEvent++)
+    {
+      int n = offsets[iEvent + 1] - offsets[iEvent];
+      if (iKernel == 0)
+        ComputeTrackBinsReference(&px[offsets[iEvent]], &py[offsets[iEvent]], n, reactionPlanes[iEvent], binning.track, tracks);
+      else
+        ComputeTrackBins(&px[offsets[iEvent]], &py[offsets[iEvent]], n, reactionPlanes[iEvent], binning.track, tracks);
+    }
+    seconds[iKernel] = timer.RealTime();
+  }
+  std::cout << "Reference kernel: " << px.size() / seconds[0] / 1e6 << " M tracks/s, vectorized kernel: " << px.size() / seconds[1] / 1e6
+            << " M tracks/s (" << seconds[0] / seconds[1] << "x)" << std::endl;
+
+  // the vectorized kernel may differ only for tracks within rounding of a bin edge
+  double mismatch = (double)(check.pTBinMismatch + check.phiBinMismatch) / std::max(1LL, check.nTracks);
+  if (mismatch > maxMismatch)
+  {
+    std::cout << "Kernel check failed: mismatch fraction " << mismatch << " above " << maxMismatch << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+// checkpoints of the event loop: snapshots of the histogram state with the entry ranges already analyzed
+
+#ifndef checkpoint_h
+#define checkpoint_h
+
+#include "analysis.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// sorted, disjoint entry ranges [first, last) of the chain
+typedef std::vector<std::pair<Long64_t, Long64_t>> EntryRanges;
+
+// add [first, last) to the ranges (adjacent or overlapping ranges are joined)
+void AddRange(EntryRanges &ranges, Long64_t first, Long64_t last);
+// entries of [0, NEntries) not covered by the ranges
+EntryRanges MissingRanges(const EntryRanges &done, Long64_t NEntries);
+// split ranges into n parts with (nearly) the same number of entries, keeping the entry order
+std::vector<EntryRanges> SplitRanges(const EntryRanges &ranges, int n);
+
+// directory of snapshots of a run: gen<generation>_worker<i>.root written during the event loop of a run,
+// gen<generation>_merged.root with everything done up to the end of that run (it replaces all snapshots before it)
+class CheckpointStore
+{
+public:
+  // the input files are stored in the snapshots ~ resuming is allowed if they are the first ones of the current input
+  CheckpointStore(const std::string &dir, const std::vector<std::string> &inputFiles);
+
+  // true if there are snapshots in the directory
+  bool Exists() const;
+  // add the state of the snapshots (latest merged one and the later worker snapshots) and the entry ranges they cover,
+  // false if one of them was written for other input files or with other settings (AnalysisConfig::Fingerprint)
+  bool Load(std::vector<HistogramSet *> &h, const AnalysisConfig &config, EntryRanges &done);
+  // write a snapshot of the histograms filled from the given entry ranges (atomically)
+  bool Write(const std::string &filename, const std::vector<HistogramSet *> &h, const AnalysisConfig &config, const RunStats &stats,
+             const EntryRanges &done) const;
+  // snapshot of the whole state at the end of the run, the snapshots it contains are removed
+  bool Consolidate(const std::vector<HistogramSet *> &h, const AnalysisConfig &config, const RunStats &stats, const EntryRanges &done);
+
+  std::string WorkerFileName(int iWorker) const;
+  const std::string &GetDir() const { return fDir; }
+
+private:
+  // snapshot files of the directory with their generation, sorted by name
+  std::vector<std::pair<std::string, int>> List() const;
+
+  std::string fDir;
+  std::vector<std::string> fInputFiles;
+  // generation of this run ~ one above those in the directory
+  int fGeneration;
+};
+
+// periodic snapshots of the histograms of a worker
+class WorkerCheckpoint
+{
+public:
+  WorkerCheckpoint(const CheckpointStore &store, int iWorker, long long interval);
+  // entries [first, last) were added to the histograms ~ a snapshot is written after every interval events
+  void BlockDone(Long64_t first, Long64_t last, const std::vector<HistogramSet *> &h, const AnalysisConfig &config, const RunStats &stats);
+
+private:
+  const CheckpointStore &fStore;
+  std::string fFileName;
+  long long fInterval;
+  long long fSinceSnapshot = 0;
+  EntryRanges fDone;
+};
+
+#endif
@@ -0,0 +1,26 @@
+// file-parallel processing of a file list: jobs of a few files run in their own processes and write partial outputs
+
+#ifndef file_parallel_h
+#define file_parallel_h
+
+#include "analysis.h"
+#include <string>
+#include <vector>
+
+// files [first, last) of the file list
+struct FileJob
+{
+  int first;
+  int last;
+  // partial output of the job
+  std::string partial;
+};
+
+// process the files in jobs of filesPerJob files on up to NProcesses processes, writing the partial outputs into partialDir
+// ~ existing partial outputs written for the same files and settings are not recomputed (a rerun continues an interrupted job),
+// ~ every file of a failed (or crashed) job is retried alone in its own process
+// the partial outputs covering all files are returned in the order of the file list, false if some files still failed
+bool RunFileJobs(const std::vector<std::string> &files, int filesPerJob, int NProcesses, const std::string &partialDir,
+                 const AnalysisConfig &config, std::vector<std::string> &partials);
+
+#endif
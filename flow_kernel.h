@@ -0,0 +1,77 @@
+// per track kernel: transverse momentum, azimuthal angle relative to the reaction plane, cos(2 (phi - Psi)) and histogram bins
+
+#ifndef flow_kernel_h
+#define flow_kernel_h
+
+#include <TROOT.h>
+#include <vector>
+
+// binning used by the kernel
+struct KernelBinning
+{
+  // pT bin i is [pTEdges[i], pTEdges[i + 1])
+  std::vector<double> pTEdges;
+  // (nearly) equal width pT bins ~ O(1) bin lookup instead of a binary search
+  bool uniformPT = true;
+  // tracks above this pT are not binned
+  double pTMax;
+  // azimuthal histogram axis, bins are numbered as in TH1 (0 ~ underflow, nPhi + 1 ~ overflow)
+  int nPhi;
+  double phiMin;
+  double phiMax;
+
+  int NpT() const { return (int)pTEdges.size() - 1; }
+};
+
+// per track results of the kernel for one event
+struct TrackBuffer
+{
+  std::vector<double> pT;
+  std::vector<double> phiRP;
+  // cos(2 (phi - Psi)) for the Fourier coefficient estimate of v2
+  std::vector<double> cos2;
+  // -1 if the track is outside of the pT binning
+  std::vector<int> pTBin;
+  std::vector<int> phiBin;
+
+  void Resize(int n);
+};
+
+// compare the vectorized kernel to the reference
+struct KernelCheck
+{
+  long long nTracks = 0;
+  long long pTBinMismatch = 0;
+  long long phiBinMismatch = 0;
+  double maxPTDiff = 0.;
+  double maxPhiDiff = 0.;
+  double maxCos2Diff = 0.;
+
+  void Add(const KernelCheck &other);
+  void Print() const;
+};
+
+// vectorized (SSE2) kernel for the n tracks of an event
+void ComputeTrackBins(const Float_t *px, const Float_t *py, int n, double reactionPlane, const KernelBinning &binning, TrackBuffer &out);
+// scalar reference with the original per track arithmetic
+void ComputeTrackBinsReference(const Float_t *px, const Float_t *py, int n, double reactionPlane, const KernelBinning &binning, TrackBuffer &out);
+// run both kernels and record their differences
+void CompareTrackKernels(const Float_t *px, const Float_t *py, int n, double reactionPlane, const KernelBinning &binning, KernelCheck &check);
+
+// kernel for tracks with quantized pT and azimuthal angle (skim cache) ~ pT bins from a lookup table over the 16 bit codes
+class QuantizedKernel
+{
+public:
+  // pT of every code (65536 values), the azimuthal angle of code i is phiOffset + i * phiStep
+  QuantizedKernel(const KernelBinning &binning, const std::vector<double> &pTValues, double phiStep, double phiOffset);
+  void Compute(const UShort_t *pTCodes, const UShort_t *phiCodes, int n, double reactionPlane, TrackBuffer &out) const;
+
+private:
+  KernelBinning fBinning;
+  std::vector<double> fPT;
+  std::vector<int> fPTBin;
+  double fPhiStep;
+  double fPhiOffset;
+};
+
+#endif
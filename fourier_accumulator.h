@@ -0,0 +1,55 @@
+// per cell sums for the Fourier coefficient estimate of elliptic flow, v2 = <cos(2 (phi - Psi))>
+
+#ifndef fourier_accumulator_h
+#define fourier_accumulator_h
+
+#include <TROOT.h>
+#include <cstddef>
+#include <vector>
+
+class FourierAccumulator
+{
+public:
+  // sums of one (centrality, pT) cell in fixed point ~ integer sums are exact and do not depend on the order of merging
+  struct Cell
+  {
+    Long64_t count;
+    Long64_t sumCos2;   // sum of cos(2 (phi - Psi)) in units of 1 / kScale
+    Long64_t sumCos2Sq; // sum of cos^2(2 (phi - Psi)) in units of 1 / kScale
+  };
+
+  // 2^20 units per 1 ~ 5e-7 rounding per track, and the sums of up to 8e9 tracks per cell stay exact as doubles (partial outputs)
+  static const int kScaleBits = 20;
+  static constexpr double kScale = (double)(1ll << kScaleBits);
+  // value in units of 1 / kScale, rounded to the nearest
+  static Long64_t Quantize(double x) { return (Long64_t)(x * kScale + (x < 0. ? -0.5 : 0.5)); }
+
+  FourierAccumulator(int NC, int NpT);
+
+  // fill n tracks of a centrality class without branches ~ tracks with pT bin -1 go to a spare cell
+  void Fill(int iCentr, const int *pTBin, const double *cos2, int n);
+  // add the sums of another accumulator with the same binning
+  void Add(const FourierAccumulator &other);
+  void Reset();
+
+  // sums of all cells (count, sumCos2, sumCos2Sq as integral doubles) ~ the state written to partial outputs
+  std::vector<double> Serialize() const;
+  // add sums from Serialize of an accumulator with the same binning, false if the size differs
+  bool AddSerialized(const double *values, size_t n);
+
+  const Cell &GetCell(int iCentr, int ipT) const { return fCells[Index(iCentr, ipT)]; }
+  // mean of cos(2 (phi - Psi)) and its statistical error in a cell (without reaction plane resolution correction)
+  void Estimate(int iCentr, int ipT, double &v2, double &v2Err) const;
+
+  int GetNC() const { return fNC; }
+  int GetNpT() const { return fNpT; }
+
+private:
+  size_t Index(int iCentr, int ipT) const { return (size_t)iCentr * (fNpT + 1) + ipT; }
+
+  int fNC;
+  int fNpT;
+  std::vector<Cell> fCells;
+};
+
+#endif
@@ -0,0 +1,117 @@
+// synthetic particle_tree for benchmarks: events with the branches of the measured data and a known elliptic flow
+
+// including used libraries
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <TFile.h>
+#include <TTree.h>
+#include <TRandom3.h>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// max number of tracks in an event
+const int kMaxTracks = 200;
+
+// elliptic flow (v2) of the generated tracks as a function of pT and centrality
+double V2(double pT, int centrality)
+{
+  return std::min(0.25, 0.1 * pT) * (0.3 + 0.7 * centrality / 100.);
+}
+
+// main function
+int main(int argc, const char **argv)
+{
+  // checking number of arguments
+  if (argc < 3)
+  {
+    std::cout << "Usage: " << argv[0] << " <output file name> <number of events> <seed=1>" << std::endl;
+    std::exit(-1);
+  }
+  std::string outFileName(argv[1]);
+  long long NEvents = atoll(argv[2]);
+  TRandom3 random(argc >= 4 ? atoi(argv[3]) : 1);
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // branches as in the measured data
+  Int_t Nevents = 0;
+  Float_t Zvertex;
+  Int_t Centrality;
+  Float_t ReactionPlane;
+  Int_t Ntracks;
+  Float_t px[kMaxTracks], py[kMaxTracks], pz[kMaxTracks], E[kMaxTracks];
+  Int_t ch[kMaxTracks], Mch[kMaxTracks];
+  Float_t isPi[kMaxTracks], detp[kMaxTracks], detz[kMaxTracks];
+
+  TFile *f = new TFile(outFileName.c_str(), "RECREATE");
+  if (!f->IsWritable())
+  {
+    std::cout << "File " << outFileName << " was not opened!" << std::endl;
+    std::exit(-1);
+  }
+  TTree *tree = new TTree("particle_tree", "Tree of particles");
+  tree->Branch("Nevents", &Nevents, "Nevents/I");
+  tree->Branch("Zvertex", &Zvertex, "Zvertex/F");
+  tree->Branch("Centrality", &Centrality, "Centrality/I");
+  tree->Branch("ReactionPlane", &ReactionPlane, "ReactionPlane/F");
+  tree->Branch("Ntracks", &Ntracks, "Ntracks/I");
+  tree->Branch("px", px, "px[Ntracks]/F");
+  tree->Branch("py", py, "py[Ntracks]/F");
+  tree->Branch("pz", pz, "pz[Ntracks]/F");
+  tree->Branch("E", E, "E[Ntracks]/F");
+  tree->Branch("ch", ch, "ch[Ntracks]/I");
+  tree->Branch("Mch", Mch, "Mch[Ntracks]/I");
+  tree->Branch("isPi", isPi, "isPi[Ntracks]/F");
+  tree->Branch("detp", detp, "detp[Ntracks]/F");
+  tree->Branch("detz", detz, "detz[Ntracks]/F");
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // GENERATE EVENTS
+  const double pionMass = 0.13957;
+  for (long long iEvent = 0; iEvent < NEvents; iEvent++)
+  {
+    if (iEvent > 0 && iEvent % 100000 == 0)
+      std::cout << "Generating event #" << iEvent << std::endl;
+    Nevents = iEvent;
+    Zvertex = random.Gaus(0., 10.);
+    Centrality = (int)random.Uniform(0., 100.);
+    ReactionPlane = random.Uniform(-M_PI_2, M_PI_2);
+    // more tracks in central events
+    Ntracks = std::min<int>(kMaxTracks, (int)random.Poisson(2. + 30. * (1. - Centrality / 100.)));
+
+    for (int iPart = 0; iPart < Ntracks; iPart++)
+    {
+      // exponential pT spectrum above 0.1 GeV/c
+      double pT = 0.1 + random.Exp(0.4);
+      // azimuthal angle from 1 + 2 v2 cos(2 (phi - Psi)) by accept-reject
+      double v2 = V2(pT, Centrality);
+      double phi;
+      do
+        phi = random.Uniform(-M_PI, M_PI);
+      while (random.Uniform(0., 1. + 2. * v2) > 1. + 2. * v2 * std::cos(2. * (phi - ReactionPlane)));
+      px[iPart] = pT * std::cos(phi);
+      py[iPart] = pT * std::sin(phi);
+      pz[iPart] = random.Gaus(0., 0.5);
+      E[iPart] = std::sqrt(pT * pT + pz[iPart] * pz[iPart] + pionMass * pionMass);
+      ch[iPart] = random.Uniform() < 0.5 ? -1 : 1;
+      // matching and identification in sigmas
+      Mch[iPart] = (int)std::lround(random.Gaus(0., 1.5));
+      isPi[iPart] = std::round(2. * random.Gaus(0., 1.5)) / 2.;
+      detp[iPart] = phi;
+      detz[iPart] = Zvertex + random.Gaus(0., 50.);
+    }
+    tree->Fill();
+  }
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // WRITE THE TREE
+  std::cout << "Writing " << NEvents << " events to " << outFileName << std::endl;
+  f->cd();
+  tree->Write();
+  f->Close();
+}
@@ -0,0 +1,52 @@
+// dense bank of the azimuthal histograms ~ one contiguous array of counts indexed by (centrality, pT bin, phi bin)
+
+#ifndef histogram_bank_h
+#define histogram_bank_h
+
+#include <TROOT.h>
+#include <vector>
+
+class TH1D;
+
+class HistogramBank
+{
+public:
+  // nPhi bins in [phiMin, phiMax) plus under/overflow for NC x NpT cells
+  HistogramBank(int NC, int NpT, int nPhi, double phiMin, double phiMax);
+
+  // fill one track, phi bins are numbered as in TH1 (0 ~ underflow, nPhi + 1 ~ overflow)
+  void Fill(int iCentr, int ipT, int phiBin) { fCounts[Index(iCentr, ipT, phiBin)]++; }
+  // fill n tracks of a centrality class without branches ~ tracks with pT bin -1 go to a spare row
+  void Fill(int iCentr, const int *pTBin, const int *phiBin, int n);
+
+  ULong64_t GetBinContent(int iCentr, int ipT, int phiBin) const { return fCounts[Index(iCentr, ipT, phiBin)]; }
+  // add the counts of another bank with the same binning
+  void Add(const HistogramBank &other);
+  void Reset();
+
+  // all counts (as doubles, exact below 2^53) ~ the state written to partial outputs
+  std::vector<double> Serialize() const;
+  // add counts from Serialize of a bank with the same binning, false if the size differs
+  bool AddSerialized(const double *values, size_t n);
+
+  // create a TH1D with the contents of the given cell
+  TH1D *Materialize(int iCentr, int ipT, const char *name, const char *title) const;
+
+  int GetNC() const { return fNC; }
+  int GetNpT() const { return fNpT; }
+  int GetNPhi() const { return fNPhi; }
+
+private:
+  // rows are (centrality, pT) cells, the extra pT row of every centrality collects the unbinned tracks
+  size_t Index(int iCentr, int ipT, int phiBin) const { return ((size_t)iCentr * (fNpT + 1) + ipT) * fRowSize + phiBin; }
+
+  int fNC;
+  int fNpT;
+  int fNPhi;
+  int fRowSize;
+  double fPhiMin;
+  double fPhiMax;
+  std::vector<ULong64_t> fCounts;
+};
+
+#endif
@@ -0,0 +1,68 @@
+// merge partial outputs of analyzetree (--file-parallel) and determine elliptic flow (v2) from the merged histograms
+
+// including used libraries
+#include "analysis.h"
+#include <TStopwatch.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// main function
+int main(int argc, const char **argv)
+{
+  // wall time of the whole run
+  TStopwatch wallTime;
+  wallTime.Start();
+  // separating options (--name) from positional arguments
+  std::vector<std::string> args;
+  std::vector<std::string> options;
+  for (int iArg = 1; iArg < argc; iArg++)
+    (std::string(argv[iArg]).compare(0, 2, "--") == 0 ? options : args).push_back(argv[iArg]);
+  // the binning and the variants have to be the same as those of the partial outputs
+  AnalysisConfig config;
+  if (!config.ParseOptions(options))
+    std::exit(-1);
+  for (const auto &option : options)
+  {
+    std::cout << "Unknown option " << option << std::endl;
+    std::exit(-1);
+  }
+
+  // checking number of arguments
+  if (args.size() < 2)
+  {
+    std::cout << "Usage: " << argv[0] << " <output file name> <partial output files...>" << std::endl;
+    AnalysisConfig::PrintOptions();
+    std::exit(-1);
+  }
+  std::string outFileName(args[0]);
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // MERGE PARTIAL OUTPUTS IN THE GIVEN ORDER
+  TH1::AddDirectory(kFALSE);
+  // counters of the runs that wrote the partial outputs, with the time of merging and writing
+  RunStats stats;
+  std::vector<HistogramSet *> histograms(config.variants.size());
+  for (size_t iVariant = 0; iVariant < config.variants.size(); iVariant++)
+    histograms[iVariant] = new HistogramSet(config.variants[iVariant].binning, "", config.subsamples);
+  {
+    ScopedTimer timer(stats.merge);
+    for (size_t iArg = 1; iArg < args.size(); iArg++)
+    {
+      std::cout << "Adding " << args[iArg] << std::endl;
+      if (!AddPartial(args[iArg], histograms, config, stats))
+        std::exit(-1);
+    }
+    for (auto h : histograms)
+      h->ResetStats();
+  }
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // DETERMINE elliptic flow (v2) AND WRITE ALL HISTOGRAMS TO THE OUTPUT ROOT FILE
+  WriteOutput(outFileName, histograms, config, stats);
+  ReportStats(stats, config, wallTime.RealTime(), 1, outFileName);
+}
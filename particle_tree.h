@@ -11,6 +11,8 @@
 #include <TROOT.h>
 #include <TChain.h>
 #include <TFile.h>
+#include <string>
+#include <vector>
 
 class particle_tree
 {
@@ -24,15 +26,17 @@ public:
    Int_t Centrality;
    Float_t ReactionPlane;
    Int_t Ntracks;
-   Float_t px[65];   //[Ntracks]
-   Float_t py[65];   //[Ntracks]
-   Float_t pz[65];   //[Ntracks]
-   Float_t E[65];    //[Ntracks]
-   Int_t ch[65];     //[Ntracks]
-   Int_t Mch[65];    //[Ntracks]
-   Float_t isPi[65]; //[Ntracks]
-   Float_t detp[65]; //[Ntracks]
-   Float_t detz[65]; //[Ntracks]
+   // per track arrays are sized to the maximum of Ntracks in the current tree (see Notify)
+   Int_t fMaxTracks;            //!capacity of the per track arrays
+   std::vector<Float_t> px;     //[Ntracks]
+   std::vector<Float_t> py;     //[Ntracks]
+   std::vector<Float_t> pz;     //[Ntracks]
+   std::vector<Float_t> E;      //[Ntracks]
+   std::vector<Int_t> ch;       //[Ntracks]
+   std::vector<Int_t> Mch;      //[Ntracks]
+   std::vector<Float_t> isPi;   //[Ntracks]
+   std::vector<Float_t> detp;   //[Ntracks]
+   std::vector<Float_t> detz;   //[Ntracks]
 
    // List of branches
    TBranch *b_Nevents;       //!
@@ -50,8 +54,14 @@ public:
    TBranch *b_detp;          //!
    TBranch *b_detz;          //!
 
+   // branches enabled by ActivateBranches (only these are cached)
+   std::vector<std::string> fActiveBranches; //!
+
    particle_tree(const char *filename = "measure_createtree.root");
+   particle_tree(const std::vector<std::string> &filenames);
    virtual ~particle_tree();
+   virtual void ActivateBranches(const std::vector<std::string> &branches);
+   virtual void EnableCache(Long64_t cacheSize, Long64_t first, Long64_t last);
    virtual Int_t Cut(Long64_t entry);
    virtual Int_t GetEntry(Long64_t entry);
    virtual Long64_t LoadTree(Long64_t entry);
@@ -59,6 +69,12 @@ public:
    virtual void Loop();
    virtual Bool_t Notify();
    virtual void Show(Long64_t entry = -1);
+
+   // root files listed in a text file
+   static std::vector<std::string> ReadFileList(const char *filename);
+
+private:
+   void SetTrackAddresses();
 };
 
 #endif
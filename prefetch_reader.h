@@ -0,0 +1,70 @@
+// pipelined reader: a background thread reads (and decompresses) blocks of events into a bounded ring of track stores
+
+#ifndef prefetch_reader_h
+#define prefetch_reader_h
+
+#include "track_store.h"
+#include <TROOT.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class particle_tree;
+
+// counters of the reader ~ tell whether the analysis is I/O or CPU bound
+struct PrefetchStats
+{
+  long long blocks = 0;
+  long long events = 0;
+  // number of blocks ready when the analysis asked for the next one (summed over the requests)
+  long long queueDepthSum = 0;
+  int maxQueueDepth = 0;
+  // time the analysis waited for the reader ~ I/O bound if large
+  double analysisStallSeconds = 0.;
+  // time the reader waited for a free slot of the ring ~ CPU bound if large
+  double readerStallSeconds = 0.;
+  // time spent in reading and decompressing the blocks
+  double readSeconds = 0.;
+
+  void Add(const PrefetchStats &other);
+  void Print(int depth) const;
+};
+
+class PrefetchReader
+{
+public:
+  // read events [first, last) of the tree in blocks, depth blocks ahead (0 ~ synchronous reading on the calling thread)
+  PrefetchReader(particle_tree &p, int columns, Long64_t first, Long64_t last, Long64_t blockSize, int depth);
+  ~PrefetchReader();
+
+  // next block in entry order (nullptr after the last one), the previously returned block goes back to the reader
+  const TrackStore *Next();
+  // valid after Next returned nullptr
+  const PrefetchStats &GetStats() const { return fStats; }
+
+private:
+  // loop of the background thread
+  void Run();
+
+  particle_tree &fTree;
+  Long64_t fFirst;
+  Long64_t fLast;
+  Long64_t fBlockSize;
+  int fDepth;
+  // block i is stored in fRing[i % size] ~ depth blocks ahead of the one being analyzed
+  std::vector<TrackStore> fRing;
+  // blocks [fConsumed, fProduced) are ready, blocks below fReleased are free again
+  long long fProduced = 0;
+  long long fConsumed = 0;
+  long long fReleased = 0;
+  bool fDone = false;
+  bool fStop = false;
+  std::mutex fMutex;
+  std::condition_variable fReadyCondition;
+  std::condition_variable fFreeCondition;
+  std::thread fThread;
+  PrefetchStats fStats;
+};
+
+#endif
@@ -0,0 +1,122 @@
+// subsample statistics of the event loop: jackknife errors of v2 and the reaction plane resolution from three sub-events
+
+#ifndef resampling_h
+#define resampling_h
+
+#include "binning.h"
+#include "flow_kernel.h"
+#include "histogram_bank.h"
+#include "fourier_accumulator.h"
+#include <TROOT.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// sums of the sub-event correlations of a centrality class
+// (A ~ reaction plane of the data, B and C ~ Q-vectors of the tracks with pz > 0 and pz < 0)
+// in the fixed point units of FourierAccumulator ~ exact and independent of the order of merging
+struct ResolutionSums
+{
+  Long64_t count;
+  Long64_t sumAB; // sum of cos(2 (Psi_A - Psi_B))
+  Long64_t sumAC;
+  Long64_t sumBC;
+};
+
+// estimate on the full sample with its jackknife error
+struct Resampled
+{
+  double value = 0.;
+  double error = 0.;
+};
+
+// estimates of a variant from the subsamples
+struct ResamplingResult
+{
+  // reaction plane resolution of the centrality classes from the three sub-events (0 if not measurable)
+  std::vector<Resampled> resolution;
+  // v2 of the (centrality, pT) cells from fits and from <cos(2 (phi - Psi))>, corrected with the measured resolution
+  std::vector<std::vector<Resampled>> v2Fit;
+  std::vector<std::vector<Resampled>> v2Fourier;
+  // the same without correction
+  std::vector<std::vector<Resampled>> v2FitNonCorr;
+  std::vector<std::vector<Resampled>> v2FourierNonCorr;
+};
+
+class Resampling
+{
+public:
+  // every event goes to one of NSubsamples subsamples with its own histograms and sums
+  Resampling(int NSubsamples, const Binning &binning);
+
+  // subsample of an event from a hash of its entry number ~ the same for any number of threads, blocks or processes
+  static int Subsample(Long64_t entry, int NSubsamples);
+
+  // fill the tracks of an event of a centrality class (pT bin -1 ~ not used) and the correlations of its sub-events,
+  // split by the sign of pz (any signed type)
+  template <typename T>
+  void Fill(Long64_t entry, int iCentr, const TrackBuffer &tracks, int n, const T *pz);
+
+  // add the sums of another object with the same binning and number of subsamples
+  void Add(const Resampling &other);
+  // all sums (histograms, Fourier sums and sub-event correlations of every subsample) ~ the state written to partial outputs
+  std::vector<double> Serialize() const;
+  bool AddSerialized(const double *values, size_t n);
+
+  // estimates on the full sample, errors from the jackknife replicas (all subsamples but one) evaluated on the given threads
+  ResamplingResult Evaluate(int threads) const;
+
+  int GetNSubsamples() const { return fNSubsamples; }
+
+private:
+  // uncorrected estimates of a sample
+  struct Estimates
+  {
+    std::vector<double> resolution;
+    std::vector<std::vector<double>> v2Fit;
+    std::vector<std::vector<double>> v2Fourier;
+  };
+  // estimates from the sums of all subsamples minus those of subsample iOmit (-1 ~ full sample)
+  Estimates Estimate(const HistogramBank &bank, const FourierAccumulator &fourier, const std::vector<ResolutionSums> &resolution,
+                     int iOmit) const;
+
+  int fNSubsamples;
+  int fNC;
+  int fNpT;
+  KernelBinning fTrackBinning;
+  std::vector<HistogramBank> fBanks;
+  std::vector<FourierAccumulator> fFourier;
+  // [iSubsample * NC + iCentr]
+  std::vector<ResolutionSums> fResolution;
+};
+
+template <typename T>
+void Resampling::Fill(Long64_t entry, int iCentr, const TrackBuffer &tracks, int n, const T *pz)
+{
+  int iSub = Subsample(entry, fNSubsamples);
+  fBanks[iSub].Fill(iCentr, tracks.pTBin.data(), tracks.phiBin.data(), n);
+  fFourier[iSub].Fill(iCentr, tracks.pTBin.data(), tracks.cos2.data(), n);
+
+  // Q-vectors of the sub-events in the frame of the reaction plane ~ their directions are 2 (Psi_B - Psi_A) and 2 (Psi_C - Psi_A)
+  double QB[2] = {0., 0.};
+  double QC[2] = {0., 0.};
+  for (int i = 0; i < n; i++)
+  {
+    if (tracks.pTBin[i] < 0 || pz[i] == 0)
+      continue;
+    double *Q = pz[i] > 0 ? QB : QC;
+    Q[0] += tracks.cos2[i];
+    Q[1] += std::sin(2. * tracks.phiRP[i]);
+  }
+  double normB = std::hypot(QB[0], QB[1]);
+  double normC = std::hypot(QC[0], QC[1]);
+  if (normB == 0. || normC == 0.)
+    return;
+  ResolutionSums &sums = fResolution[(size_t)iSub * fNC + iCentr];
+  sums.count++;
+  sums.sumAB += FourierAccumulator::Quantize(QB[0] / normB);
+  sums.sumAC += FourierAccumulator::Quantize(QC[0] / normC);
+  sums.sumBC += FourierAccumulator::Quantize((QB[0] * QC[0] + QB[1] * QC[1]) / (normB * normC));
+}
+
+#endif
@@ -0,0 +1,62 @@
+// instrumentation of the analysis: wall time of the stages (reading, track loop, fits, writing) and throughput counters
+
+#ifndef run_stats_h
+#define run_stats_h
+
+#include "prefetch_reader.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// accumulated wall time of a stage
+struct StageTimer
+{
+  double seconds = 0.;
+  long long calls = 0;
+};
+
+// measures the wall time of a scope and adds it to a stage
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer(StageTimer &timer) : fTimer(timer), fStart(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer()
+  {
+    fTimer.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - fStart).count();
+    fTimer.calls++;
+  }
+
+private:
+  StageTimer &fTimer;
+  std::chrono::steady_clock::time_point fStart;
+};
+
+// counters of a run (one per worker, summed at the end)
+struct RunStats
+{
+  // reading (GetEntry) through the prefetching reader ~ also the events read and the queue/stall counters
+  PrefetchStats reader;
+  // per track loop: kernel and filling of all variants
+  StageTimer trackLoop;
+  // merging of the worker histograms or of the partial outputs
+  StageTimer merge;
+  // v2 fits and Fourier estimates
+  StageTimer fit;
+  // writing of the output file
+  StageTimer write;
+  long long tracks = 0;
+  // bytes read from the input files (all threads of the process)
+  double bytesRead = 0.;
+
+  void Add(const RunStats &other);
+  // counters of the event loop ~ stored in partial outputs
+  std::vector<double> Serialize() const;
+  bool AddSerialized(const double *values, size_t n);
+
+  // human readable summary with throughput over the given wall time
+  void Print(double wallSeconds, int threads, int prefetchDepth) const;
+  // machine readable summary: JSON object (.json) or a CSV row appended to the file (.csv, .txt; header written to a new file)
+  bool Write(const std::string &filename, double wallSeconds, int threads, const std::string &label) const;
+};
+
+#endif
@@ -0,0 +1,238 @@
+// skim cache: compact binary copy of the quantities of the v2 analysis, read through a memory map (header only, also from macros)
+//
+// file layout (native byte order, every column 64 byte aligned):
+//   SkimHeader
+//   event columns: centrality (int32), reaction plane (float), Zvertex (float), first track (int64, nEvents + 1 entries)
+//   track columns: pT code (uint16), azimuthal angle code (uint16), Mch code (int8), isPi code (int8), sign of pz (int8)
+//   centrality index: event numbers (uint32) grouped by centrality, in entry order within a centrality
+
+#ifndef skim_cache_h
+#define skim_cache_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// centralities 0-100 [%] have their own group in the index, all other values are in the last one
+const int kSkimCentralities = 102;
+
+struct SkimHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  int64_t nEvents;
+  int64_t nTracks;
+  // upper end of the pT quantization [GeV/c]
+  double pTMax;
+  // byte offsets of the columns
+  int64_t centralityOffset;
+  int64_t reactionPlaneOffset;
+  int64_t zvertexOffset;
+  int64_t firstTrackOffset;
+  int64_t pTOffset;
+  int64_t phiOffset;
+  int64_t mchOffset;
+  int64_t isPiOffset;
+  int64_t sideOffset;
+  int64_t indexOffset;
+  // the events of centrality group c are index[centralityFirst[c]], ..., index[centralityFirst[c + 1] - 1]
+  int64_t centralityFirst[kSkimCentralities + 1];
+  // total size of the file
+  int64_t fileSize;
+};
+
+class SkimCache
+{
+public:
+  static constexpr const char *kMagic = "V2SKIM";
+  static const uint32_t kVersion = 2;
+  // pT codes 0, ..., kPTOverflow - 1 cover [0, pTMax], kPTOverflow ~ above pTMax
+  static const uint16_t kPTOverflow = 0xffff;
+  static constexpr double kPhiStep = 2. * M_PI / 65536.;
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // quantization (the writer) and decoding of the codes
+  static uint16_t EncodePT(double pT, double pTMax)
+  {
+    if (!(pT <= pTMax))
+      return kPTOverflow;
+    return (uint16_t)std::lround(std::max(0., pT) / pTMax * (kPTOverflow - 1));
+  }
+  static double DecodePT(uint16_t code, double pTMax)
+  {
+    return code == kPTOverflow ? std::numeric_limits<double>::infinity() : code * pTMax / (kPTOverflow - 1);
+  }
+  // azimuthal angle in [-pi, pi), 9.6e-5 rad steps
+  static uint16_t EncodePhi(double phi)
+  {
+    return (uint16_t)((long)std::lround((phi + M_PI) / kPhiStep) & 0xffff);
+  }
+  static double DecodePhi(uint16_t code)
+  {
+    return code * kPhiStep - M_PI;
+  }
+  // matching and identification variables in half sigma steps, |value| up to 63.5 sigma
+  static int8_t EncodeSigma(double sigma)
+  {
+    return (int8_t)std::lround(std::min(127., std::max(-127., 2. * sigma)));
+  }
+  static double DecodeSigma(int8_t code)
+  {
+    return code / 2.;
+  }
+  // offsets of the columns and size of the file for the numbers of events and tracks of the header
+  static void Layout(SkimHeader &header)
+  {
+    // 64 byte (cache line) alignment of every column
+    auto next = [](int64_t offset) { return (offset + 63) / 64 * 64; };
+    header.centralityOffset = next(sizeof(SkimHeader));
+    header.reactionPlaneOffset = next(header.centralityOffset + 4 * header.nEvents);
+    header.zvertexOffset = next(header.reactionPlaneOffset + 4 * header.nEvents);
+    header.firstTrackOffset = next(header.zvertexOffset + 4 * header.nEvents);
+    header.pTOffset = next(header.firstTrackOffset + 8 * (header.nEvents + 1));
+    header.phiOffset = next(header.pTOffset + 2 * header.nTracks);
+    header.mchOffset = next(header.phiOffset + 2 * header.nTracks);
+    header.isPiOffset = next(header.mchOffset + header.nTracks);
+    header.sideOffset = next(header.isPiOffset + header.nTracks);
+    header.indexOffset = next(header.sideOffset + header.nTracks);
+    header.fileSize = header.indexOffset + 4 * header.nEvents;
+  }
+  // group of a centrality in the index
+  static int CentralityGroup(int centrality)
+  {
+    return (centrality >= 0 && centrality <= 100) ? centrality : kSkimCentralities - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  SkimCache() {}
+  explicit SkimCache(const std::string &filename) { Open(filename); }
+  ~SkimCache() { Close(); }
+  SkimCache(const SkimCache &) = delete;
+  SkimCache &operator=(const SkimCache &) = delete;
+
+  // map the file, false (with the reason in GetError) if it is not a complete skim cache
+  bool Open(const std::string &filename)
+  {
+    Close();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return Fail("cannot open " + filename);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SkimHeader))
+    {
+      close(fd);
+      return Fail(filename + " is not a skim cache");
+    }
+    // the mapping stays valid after closing the descriptor
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+      return Fail("cannot map " + filename);
+    fData = (const char *)data;
+    fSize = st.st_size;
+    fHeader = (const SkimHeader *)fData;
+    if (std::strncmp(fHeader->magic, kMagic, sizeof(fHeader->magic)) != 0 || fHeader->version != kVersion ||
+        fHeader->headerSize != sizeof(SkimHeader) || fHeader->fileSize != fSize || !HasLayout(*fHeader))
+    {
+      Close();
+      return Fail(filename + " is not a complete skim cache of version " + std::to_string(kVersion));
+    }
+    // the columns are read in order ~ read ahead by the kernel
+    madvise(data, fSize, MADV_SEQUENTIAL);
+    return true;
+  }
+
+  void Close()
+  {
+    if (fData)
+      munmap((void *)fData, fSize);
+    fData = nullptr;
+    fHeader = nullptr;
+    fSize = 0;
+  }
+
+  bool IsOpen() const { return fData != nullptr; }
+  const std::string &GetError() const { return fError; }
+  const SkimHeader &Header() const { return *fHeader; }
+  int64_t NEvents() const { return fHeader->nEvents; }
+  int64_t NTracks() const { return fHeader->nTracks; }
+  double PTMax() const { return fHeader->pTMax; }
+
+  // columns in the mapped file (no copies)
+  const int32_t *Centrality() const { return Column<int32_t>(fHeader->centralityOffset); }
+  const float *ReactionPlane() const { return Column<float>(fHeader->reactionPlaneOffset); }
+  const float *Zvertex() const { return Column<float>(fHeader->zvertexOffset); }
+  // tracks of event i are [FirstTrack()[i], FirstTrack()[i + 1])
+  const int64_t *FirstTrack() const { return Column<int64_t>(fHeader->firstTrackOffset); }
+  const uint16_t *PT() const { return Column<uint16_t>(fHeader->pTOffset); }
+  const uint16_t *Phi() const { return Column<uint16_t>(fHeader->phiOffset); }
+  const int8_t *Mch() const { return Column<int8_t>(fHeader->mchOffset); }
+  const int8_t *IsPi() const { return Column<int8_t>(fHeader->isPiOffset); }
+  // +1 for pz > 0, -1 for pz < 0 (sub-events of the resolution)
+  const int8_t *Side() const { return Column<int8_t>(fHeader->sideOffset); }
+
+  // event numbers with centrality in [low, high] (within 0-100), n is set to their number
+  const uint32_t *CentralityEvents(int low, int high, int64_t &n) const
+  {
+    low = std::max(low, 0);
+    high = std::min(high, 100);
+    const uint32_t *index = Column<uint32_t>(fHeader->indexOffset);
+    n = low <= high ? fHeader->centralityFirst[high + 1] - fHeader->centralityFirst[low] : 0;
+    return index + fHeader->centralityFirst[std::min(low, 100)];
+  }
+
+  // decoded pT of every code ~ lookup table of the kernel
+  std::vector<double> PTValues() const
+  {
+    std::vector<double> values(65536);
+    for (int code = 0; code < 65536; code++)
+      values[code] = DecodePT(code, PTMax());
+    return values;
+  }
+
+private:
+  template <typename T>
+  const T *Column(int64_t offset) const
+  {
+    return (const T *)(fData + offset);
+  }
+
+  // the offsets are those of the layout ~ all columns are inside the file
+  static bool HasLayout(const SkimHeader &header)
+  {
+    if (header.nEvents < 0 || header.nTracks < 0)
+      return false;
+    for (int c = 0; c < kSkimCentralities; c++)
+      if (header.centralityFirst[c] < 0 || header.centralityFirst[c] > header.centralityFirst[c + 1])
+        return false;
+    if (header.centralityFirst[kSkimCentralities] != header.nEvents)
+      return false;
+    SkimHeader layout = header;
+    Layout(layout);
+    return std::memcmp(&layout, &header, sizeof(SkimHeader)) == 0;
+  }
+
+  bool Fail(const std::string &error)
+  {
+    fError = error;
+    return false;
+  }
+
+  const char *fData = nullptr;
+  int64_t fSize = 0;
+  const SkimHeader *fHeader = nullptr;
+  std::string fError;
+};
+
+#endif
@@ -0,0 +1,210 @@
+// skim of particle_tree into the skim cache: centrality, reaction plane and Zvertex per event, quantized pT, azimuthal angle,
+// Mch, isPi and the sign of pz per track ~ later runs of analyzetree.exe and the plot macros read it through a memory map
+
+// including used libraries
+#include "particle_tree.h"
+#include "analysis.h"
+#include "skim_cache.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <TStopwatch.h>
+
+// ------------------------------------------------------------------------------------------------------------------------------
+
+// main function
+int main(int argc, const char **argv)
+{
+  TStopwatch wallTime;
+  wallTime.Start();
+  // separating options (--name) from positional arguments
+  std::vector<std::string> args;
+  double pTMax = 10.;
+  for (int iArg = 1; iArg < argc; iArg++)
+  {
+    std::string arg(argv[iArg]);
+    if (arg.compare(0, 9, "--pt-max=") == 0)
+      pTMax = atof(arg.substr(9).c_str());
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cout << "Unknown option " << arg << std::endl;
+      std::exit(-1);
+    }
+    else
+      args.push_back(arg);
+  }
+  // checking number of arguments
+  if (args.size() < 2 || !(pTMax > 0.))
+  {
+    std::cout << "Usage: " << argv[0] << " <input file name> <output file name (.skim)> <max events=-1>" << std::endl;
+    std::cout << "Options: --pt-max=10 (upper end of the pT quantization [GeV/c], tracks above it are kept as overflow)" << std::endl;
+    std::exit(-1);
+  }
+  std::string inFileName(args[0]);
+  std::string outFileName(args[1]);
+  long long NMaxEvent = args.size() >= 3 ? atoll(args[2].c_str()) : -1;
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // INITIALIZE particle_tree OBJECT
+  particle_tree p(inFileName.c_str());
+  if (!p.fChain)
+  {
+    std::cout << "No tree found." << std::endl;
+    std::exit(-1);
+  }
+  Long64_t NEvents = p.fChain->GetEntries();
+  if (NMaxEvent > 0 && NMaxEvent < NEvents)
+    NEvents = NMaxEvent;
+  // event numbers of the centrality index are 32 bit
+  if (NEvents > 0xffffffffll)
+  {
+    std::cout << "Too many events for a skim cache: " << NEvents << std::endl;
+    std::exit(-1);
+  }
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // COUNT THE TRACKS ~ only the Ntracks branch is read, the columns are laid out before writing them
+  AnalysisConfig config;
+  SkimHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, SkimCache::kMagic, sizeof(header.magic));
+  header.version = SkimCache::kVersion;
+  header.headerSize = sizeof(SkimHeader);
+  header.nEvents = NEvents;
+  header.pTMax = pTMax;
+  p.ActivateBranches({"Ntracks"});
+  p.EnableCache(config.cacheSize, 0, NEvents);
+  for (Long64_t iEvent = 0; iEvent < NEvents; iEvent++)
+  {
+    if (p.GetEntry(iEvent) <= 0)
+    {
+      std::cout << "Event #" << iEvent << " was not read!" << std::endl;
+      std::exit(-1);
+    }
+    header.nTracks += p.Ntracks;
+  }
+  SkimCache::Layout(header);
+  std::cout << "Skimming " << NEvents << " events with " << header.nTracks << " tracks into " << header.fileSize / double(1 << 20)
+            << " MB" << std::endl;
+
+  // ------------------------------------------------------------------------------------------------------------------------------
+
+  // WRITE THE COLUMNS BLOCK BY BLOCK ~ through a temporary file, an existing skim cache is always complete
+  std::string tmpFileName = outFileName + ".tmp";
+  std::ofstream out(tmpFileName, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::cout << "File " << tmpFileName << " was not opened!" << std::endl;
+    std::exit(-1);
+  }
+  auto write = [&out](int64_t offset, const void *data, size_t bytes) {
+    out.seekp(offset);
+    out.write((const char *)data, bytes);
+  };
+
+  // the background reader reads through the tree on its own thread
+  if (config.prefetchDepth > 0)
+    ROOT::EnableThreadSafety();
+  int columns = TrackStore::kZvertex | TrackStore::kMch | TrackStore::kIsPi | TrackStore::kPz;
+  p.ActivateBranches(TrackStore(columns).Branches());
+  p.EnableCache(config.cacheSize, 0, NEvents);
+  PrefetchReader reader(p, columns, 0, NEvents, kBlockSize, config.prefetchDepth);
+
+  // event numbers of every centrality group
+  std::vector<std::vector<uint32_t>> centralityGroups(kSkimCentralities);
+  // columns of a block
+  std::vector<int32_t> centrality;
+  std::vector<float> reactionPlane, zvertex;
+  std::vector<int64_t> firstTrack;
+  std::vector<uint16_t> pT, phi;
+  std::vector<int8_t> mch, isPi, side;
+  Long64_t iEvent = 0;
+  int64_t iTrack = 0;
+  while (const TrackStore *store = reader.Next())
+  {
+    if (store->NEvents() == 0)
+      continue;
+    if (iEvent % 100000 == 0)
+      std::cout << "Skimming event #" << iEvent << std::endl;
+    int NTracks = store->NTracks();
+    if (iTrack + NTracks > header.nTracks)
+      break;
+    centrality.assign(store->Centrality.begin(), store->Centrality.end());
+    reactionPlane.assign(store->ReactionPlane.begin(), store->ReactionPlane.end());
+    zvertex.assign(store->Zvertex.begin(), store->Zvertex.end());
+    firstTrack.resize(store->NEvents());
+    for (int i = 0; i < store->NEvents(); i++)
+    {
+      firstTrack[i] = iTrack + store->offset[i];
+      centralityGroups[SkimCache::CentralityGroup(store->Centrality[i])].push_back((uint32_t)(iEvent + i));
+    }
+
+    // quantized tracks ~ pT and azimuthal angle with the arithmetic of the reference kernel
+    pT.resize(NTracks);
+    phi.resize(NTracks);
+    mch.resize(NTracks);
+    isPi.resize(NTracks);
+    side.resize(NTracks);
+    for (int i = 0; i < NTracks; i++)
+    {
+      Float_t pT2 = store->px[i] * store->px[i] + store->py[i] * store->py[i];
+      pT[i] = SkimCache::EncodePT(std::sqrt((double)pT2), pTMax);
+      phi[i] = SkimCache::EncodePhi(std::atan2(store->py[i], store->px[i]));
+      mch[i] = SkimCache::EncodeSigma(store->Mch[i]);
+      isPi[i] = SkimCache::EncodeSigma(store->isPi[i]);
+      side[i] = store->pz[i] > 0.f ? 1 : (store->pz[i] < 0.f ? -1 : 0);
+    }
+
+    int NBlock = store->NEvents();
+    write(header.centralityOffset + 4 * iEvent, centrality.data(), 4 * NBlock);
+    write(header.reactionPlaneOffset + 4 * iEvent, reactionPlane.data(), 4 * NBlock);
+    write(header.zvertexOffset + 4 * iEvent, zvertex.data(), 4 * NBlock);
+    write(header.firstTrackOffset + 8 * iEvent, firstTrack.data(), 8 * NBlock);
+    write(header.pTOffset + 2 * iTrack, pT.data(), 2 * NTracks);
+    write(header.phiOffset + 2 * iTrack, phi.data(), 2 * NTracks);
+    write(header.mchOffset + iTrack, mch.data(), NTracks);
+    write(header.isPiOffset + iTrack, isPi.data(), NTracks);
+    write(header.sideOffset + iTrack, side.data(), NTracks);
+    iEvent += NBlock;
+    iTrack += NTracks;
+  }
+  // a read error stops the loading of a block early ~ no skim cache with missing events
+  if (iEvent != NEvents || iTrack != header.nTracks)
+  {
+    std::cout << "Read " << iEvent << " of " << NEvents << " events and " << iTrack << " of " << header.nTracks << " tracks!" << std::endl;
+    out.close();
+    std::remove(tmpFileName.c_str());
+    std::exit(-1);
+  }
+  write(header.firstTrackOffset + 8 * NEvents, &iTrack, 8);
+
+  // centrality index
+  int64_t indexed = 0;
+  for (int c = 0; c < kSkimCentralities; c++)
+  {
+    header.centralityFirst[c] = indexed;
+    write(header.indexOffset + 4 * indexed, centralityGroups[c].data(), 4 * centralityGroups[c].size());
+    indexed += centralityGroups[c].size();
+  }
+  header.centralityFirst[kSkimCentralities] = indexed;
+  write(0, &header, sizeof(header));
+  out.close();
+  if (!out || std::rename(tmpFileName.c_str(), outFileName.c_str()) != 0)
+  {
+    std::cout << "File " << outFileName << " was not written!" << std::endl;
+    std::remove(tmpFileName.c_str());
+    std::exit(-1);
+  }
+  PrefetchStats readerStats = reader.GetStats();
+  readerStats.Print(config.prefetchDepth);
+  std::cout << "Wrote " << NEvents << " events and " << header.nTracks << " tracks to " << outFileName << " in " << wallTime.RealTime()
+            << " s" << std::endl;
+}
@@ -0,0 +1,53 @@
+// columnar (structure-of-arrays) storage of the tracks of a block of events
+
+#ifndef track_store_h
+#define track_store_h
+
+#include <TROOT.h>
+#include <string>
+#include <vector>
+
+class particle_tree;
+
+class TrackStore
+{
+public:
+  // optional columns (px, py, Centrality and ReactionPlane are always read)
+  enum Column
+  {
+    kZvertex = 1 << 0,
+    kMch = 1 << 1,
+    kIsPi = 1 << 2,
+    kPz = 1 << 3
+  };
+
+  // per event columns
+  std::vector<Long64_t> entry; // entry number in the chain
+  std::vector<Int_t> Centrality;
+  std::vector<Float_t> ReactionPlane;
+  std::vector<Float_t> Zvertex; // only filled with kZvertex
+  std::vector<Int_t> offset;    // tracks of event i are [offset[i], offset[i + 1])
+  // per track columns, contiguous over the whole block
+  std::vector<Float_t> px;
+  std::vector<Float_t> py;
+  std::vector<Float_t> pz;   // only filled with kPz
+  std::vector<Int_t> Mch;    // only filled with kMch
+  std::vector<Float_t> isPi; // only filled with kIsPi
+
+  explicit TrackStore(int columns = 0);
+
+  // branches of particle_tree needed to fill the requested columns
+  std::vector<std::string> Branches() const;
+  // read events [first, last) from the tree, replacing the previous block
+  Long64_t Load(particle_tree &p, Long64_t first, Long64_t last);
+  void Clear();
+
+  int GetColumns() const { return fColumns; }
+  Int_t NEvents() const { return (Int_t)entry.size(); }
+  Int_t NTracks() const { return offset.empty() ? 0 : offset.back(); }
+
+private:
+  int fColumns;
+};
+
+#endif